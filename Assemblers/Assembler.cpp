@@ -2,6 +2,7 @@
 #define ASSEMBLER_H
 
 #include "File.h"                     // Declaração da classe File (I/O de arquivos e List).
+#include "Emitter.h"                  // Saídas (.hex, binário, header C) alimentadas na mesma passada.
 #include "iostream"                   // std::cout / std::cerr (usados em mensagens).
 #include "cmath"                      // pow etc. (aqui não é estritamente necessário).
 #include <cstdint>                    // tipos fixos (uint8_t).
@@ -13,15 +14,45 @@
 #define X mem[0]                      // Macros para acessar registradores no array mem[].
 #define Y mem[1]
 #define W mem[2]
+#define MAX_EMITTERS 8                // Quantidade máxima de saídas simultâneas.
+#define MAX_DEPTH 64                  // Aninhamento máximo de repita/macro (também barra macro recursiva).
+#define MAX_MACROS 64                 // Quantidade máxima de macros definidas.
+#define MAX_NAME 32                   // Tamanho máximo (com '\0') de nomes de macro/variável.
+
+// Diretivas de bloco da linguagem .ULA:
+//   macro nome        … fimmacro     define um bloco nomeado (só no nível de topo); chamado com "nome;"
+//   repita [var] N    … fimrepita    repete o corpo N vezes (N decimal); var vale 0..N-1 e pode ser usada
+//                                    em X=var; / Y=var; (só os 4 bits baixos)
+// A expansão é preguiçosa: uma pilha de quadros percorre as linhas do fonte, nada é expandido em memória.
+enum Directive { DIR_NONE, DIR_REPITA, DIR_FIMREPITA, DIR_MACRO, DIR_FIMMACRO };
+
+// Quadro da pilha de expansão: percorre as linhas [begin, end) do fonte 'count' vezes.
+struct Frame {
+    int begin, end;                   // Corpo do bloco (end = índice da linha fimrepita/fimmacro).
+    int pc;                           // Próxima linha a interpretar.
+    long value, count;                // Iteração atual e total de iterações.
+    char var[MAX_NAME];               // Variável de iteração ("" para programa/macro).
+};
+
+// Macro definida no fonte: corpo nas linhas [begin, end).
+struct Macro {
+    char name[MAX_NAME];
+    int begin, end;
+};
 
 class Assembler
 {
 private:
     // Atributos
     List* input;                      // Lista de linhas lidas do arquivo de entrada (.ULA).
-    List* output;                     // Lista de linhas a serem gravadas no arquivo de saída (.hex).
+    Emitter** emitters;               // Saídas registradas: cada instrução montada é repassada a todas.
+    int nEmitters;                    // Quantidade de saídas registradas.
     byte* mem;                        // Pequena “memória”: X, Y e W (3 bytes).
     bool tick;                        // Marca se W foi atualizado em uma linha (gera saída .hex).
+    Frame* frames;                    // Pilha de expansão (programa → repita/macro aninhados).
+    int depth;                        // Quadros ativos na pilha.
+    Macro* macros;                    // Macros encontradas na pré-varredura.
+    int nMacros;                      // Quantidade de macros.
 
     // Helpers
     static inline bool isHexDigit(char c) {       // Testa se c é dígito HEX (0–9, A–F, a–f).
@@ -35,37 +66,269 @@ private:
         if (c >= 'a' && c <= 'f') return (byte)(10 + (c - 'a'));
         return 0;
     }
+    static inline bool isIdentStart(char c) {     // Início de identificador: letra ou '_'.
+        return (isLetter(c) || c == '_');
+    }
+    static inline bool isIdentChar(char c) {      // Resto do identificador: letra, dígito ou '_'.
+        return (isLetter(c) || isNumber(c) || c == '_');
+    }
+    static inline int identifier(const char* str, int i, int n) { // Fim do identificador que começa em i (i se não houver).
+        if (i < n && isIdentStart(str[i])) {
+            i++;
+            while (i < n && isIdentChar(str[i])) i++;
+        }
+        return (i);
+    }
+    static inline int skipSpaces(const char* str, int i, int n) {
+        while (i < n && std::isspace((unsigned char)str[i])) i++;
+        return (i);
+    }
+    static inline bool lineEnd(const char* str, int i, int n) {  // Só sobram espaços, ';', ':' ou comentário '#'.
+        while (i < n && (std::isspace((unsigned char)str[i]) || str[i] == ';' || str[i] == ':')) i++;
+        return (i >= n || str[i] == '#');
+    }
+    static inline bool sameName(const char* name, const char* str, int s, int f) { // name == str[s,f)?
+        int len = f - s;
+        return ((int)std::strlen(name) == len && std::strncmp(name, str + s, (size_t)len) == 0);
+    }
+
+    // Reconhecer diretiva de bloco; *arg recebe o índice logo após a palavra-chave.
+    static Directive directive (const char* line, int* arg)
+    {
+        int n = (int)std::strlen(line);
+        int s = skipSpaces(line, 0, n);
+        int f = identifier(line, s, n);
+        if (arg) *arg = f;
+        if      (sameName("repita",    line, s, f)) return (DIR_REPITA);
+        else if (sameName("fimrepita", line, s, f)) return (DIR_FIMREPITA);
+        else if (sameName("macro",     line, s, f)) return (DIR_MACRO);
+        else if (sameName("fimmacro",  line, s, f)) return (DIR_FIMMACRO);
+        return (DIR_NONE);
+    }
+
+    // Ler "repita [var] N": var pode faltar; N decimal (>= 0). Retorna false se a sintaxe for inválida.
+    static bool parseRepeat (const char* line, int i, char* var, long* count)
+    {
+        int n = (int)std::strlen(line);
+        var[0] = '\0';
+        i = skipSpaces(line, i, n);
+        int e = identifier(line, i, n);
+        if (e > i) {
+            if (e - i >= MAX_NAME) return (false);
+            bool hex = true;                          // Nome só com dígitos HEX ("A", "fe") colidiria com X=A.
+            for (int k = i; k < e; k++) if (!isHexDigit(line[k])) hex = false;
+            if (hex) return (false);
+            std::strncpy(var, line + i, (size_t)(e - i));
+            var[e - i] = '\0';
+            i = skipSpaces(line, e, n);
+        }
+        if (i >= n || !isNumber(line[i])) return (false);
+        long res = 0;
+        while (i < n && isNumber(line[i])) {
+            res = res * 10 + (line[i] - '0');
+            if (res > 0x7FFFFFFFL) return (false);   // Limite de 31 bits por bloco (aninhe para ir além).
+            i++;
+        }
+        *count = res;
+        return (lineEnd(line, i, n));
+    }
+
+    // Nome reservado: palavras-chave, ou qualquer nome com "inicio"/"fim" (assemble(line) ignora essas linhas).
+    static bool reserved (const char* name)
+    {
+        return (std::strcmp(name, "repita") == 0 || std::strcmp(name, "macro") == 0 ||
+                std::strstr(name, "inicio") || std::strstr(name, "fim"));
+    }
+
+    // Ler "macro nome"; retorna false se a sintaxe for inválida.
+    static bool parseMacro (const char* line, int i, char* name)
+    {
+        int n = (int)std::strlen(line);
+        i = skipSpaces(line, i, n);
+        int e = identifier(line, i, n);
+        if (e == i || e - i >= MAX_NAME) return (false);
+        std::strncpy(name, line + i, (size_t)(e - i));
+        name[e - i] = '\0';
+        return (lineEnd(line, e, n));
+    }
+
+    // Chamada de macro ("nome;"): retorna o índice da macro ou -1.
+    int findCall (const char* line)
+    {
+        int n = (int)std::strlen(line);
+        int s = skipSpaces(line, 0, n);
+        int f = identifier(line, s, n);
+        if (f == s || !lineEnd(line, f, n)) return (-1);
+        for (int m = 0; m < nMacros; m++)
+            if (sameName(macros[m].name, line, s, f)) return (m);
+        return (-1);
+    }
+
+    // Valor da variável de iteração str[s,f), procurando do bloco mais interno para fora.
+    bool variable (const char* str, int s, int f, long* value)
+    {
+        for (int d = depth - 1; d >= 0; d--)
+            if (frames[d].var[0] && sameName(frames[d].var, str, s, f)) {
+                *value = frames[d].value;
+                return (true);
+            }
+        return (false);
+    }
+
+    // Empilhar quadro de expansão; false se passar de MAX_DEPTH.
+    bool push (int begin, int end, long count, const char* var)
+    {
+        if (depth >= MAX_DEPTH) return (false);
+        Frame* f = &frames[depth++];
+        f->begin = begin; f->end = end; f->pc = begin;
+        f->value = 0;     f->count = count;
+        std::strcpy(f->var, var ? var : "");
+        return (true);
+    }
+
+    // Pre-varredura: casa cada repita/macro com seu fim (ends[k]) e registra as macros.
+    // Custa O(linhas do fonte), independente do tamanho da expansão.
+    bool prescan (char** lines, int total, int* ends)
+    {
+        int* open = new int[total + 1](); // Pilha de blocos abertos (índices de linha).
+        int top = 0;
+        bool ok = true;
+        nMacros = 0;
+
+        for (int k = 0; k < total && ok; k++)
+        {
+            ends[k] = -1;
+            if (!lines[k]) continue;
+            int arg = 0;
+            Directive d = directive(lines[k], &arg);
+            char name[MAX_NAME] = "";
+            long count = 0;
+
+            if (d == DIR_REPITA) {
+                if (!parseRepeat(lines[k], arg, name, &count)) {
+                    std::cerr << "ERRO: linha " << k + 1 << ": use \"repita [var] N\" (var nao pode ser so HEX).\n";
+                    ok = false;
+                } else if (name[0] && reserved(name)) {
+                    std::cerr << "ERRO: linha " << k + 1 << ": nome reservado: " << name << ".\n";
+                    ok = false;
+                } else open[top++] = k;
+            }
+            else if (d == DIR_MACRO) {
+                if (top > 0) {
+                    std::cerr << "ERRO: linha " << k + 1 << ": macro so pode ser definida fora de blocos.\n";
+                    ok = false;
+                } else if (!parseMacro(lines[k], arg, name)) {
+                    std::cerr << "ERRO: linha " << k + 1 << ": use \"macro nome\".\n";
+                    ok = false;
+                } else if (reserved(name)) {
+                    std::cerr << "ERRO: linha " << k + 1 << ": nome reservado: " << name << ".\n";
+                    ok = false;
+                } else if (findCall(name) >= 0) {
+                    std::cerr << "ERRO: linha " << k + 1 << ": macro " << name << " ja definida.\n";
+                    ok = false;
+                } else if (nMacros >= MAX_MACROS) {
+                    std::cerr << "ERRO: linha " << k + 1 << ": limite de " << MAX_MACROS << " macros atingido.\n";
+                    ok = false;
+                } else {
+                    std::strcpy(macros[nMacros].name, name);
+                    macros[nMacros].begin = k + 1;
+                    macros[nMacros].end = -1;           // Completado no fimmacro.
+                    nMacros++;
+                    open[top++] = k;
+                }
+            }
+            else if (d == DIR_FIMREPITA || d == DIR_FIMMACRO) {
+                Directive want = (d == DIR_FIMREPITA) ? DIR_REPITA : DIR_MACRO;
+                if (top == 0 || directive(lines[open[top - 1]], nullptr) != want) {
+                    std::cerr << "ERRO: linha " << k + 1 << ": " << (d == DIR_FIMREPITA ? "fimrepita" : "fimmacro")
+                              << " sem bloco correspondente.\n";
+                    ok = false;
+                } else {
+                    int b = open[--top];
+                    ends[b] = k;
+                    if (want == DIR_MACRO) macros[nMacros - 1].end = k;
+                }
+            }
+        }
+
+        if (ok && top > 0) {
+            std::cerr << "ERRO: linha " << open[top - 1] + 1 << ": bloco sem fimrepita/fimmacro.\n";
+            ok = false;
+        }
+
+        // Com todas as macros conhecidas: linha só com um nome ("opss;") tem que ser chamada válida.
+        // Nomes reservados ficam de fora ("inicio:" é o cabeçalho do programa).
+        for (int k = 0; k < total && ok; k++)
+        {
+            if (!lines[k] || directive(lines[k], nullptr) != DIR_NONE) continue;
+            int n = (int)std::strlen(lines[k]);
+            int s = skipSpaces(lines[k], 0, n);
+            int f = identifier(lines[k], s, n);
+            if (f == s || f - s >= MAX_NAME || !lineEnd(lines[k], f, n)) continue;
+            char name[MAX_NAME] = "";
+            std::strncpy(name, lines[k] + s, (size_t)(f - s));
+            if (!reserved(name) && findCall(lines[k]) < 0) {
+                std::cerr << "ERRO: linha " << k + 1 << ": macro " << name << " nao definida.\n";
+                ok = false;
+            }
+        }
+        delete[] open;
+        return (ok);
+    }
 
 public:
     // Construtor
     Assembler (const char* filename)              // Inicializa assembler e lê o arquivo de entrada (se dado).
-    : input(nullptr), output(nullptr), mem(nullptr), tick(false)
+    : input(nullptr), emitters(nullptr), nEmitters(0), mem(nullptr), tick(false),
+      frames(nullptr), depth(0), macros(nullptr), nMacros(0)
     {
+        emitters = new Emitter*[MAX_EMITTERS](); // Vetor de saídas começa vazio.
+        frames = new Frame[MAX_DEPTH]();          // Pilha de expansão (tamanho fixo).
+        macros = new Macro[MAX_MACROS]();         // Tabela de macros.
         mem = new byte[3]();                      // Aloca 3 bytes zerados para X,Y,W.
         for (int i = 0; i < 3; i++) mem[i] = 0x0; // Redundante, mas garante zera.
 
         if (filename) {
-            File* f = new File(filename);         // Cria um File para o caminho fornecido.
-            input = f->read();   // pega List*   // Lê o arquivo: retorna uma List* com as linhas.
-            // (se quiser: delete f;  // depende da sua implementação)  // File é não usado depois; pode liberar.
+            std::ifstream probe (filename);       // File::read devolve lista vazia se o arquivo não abre;
+            if (probe) {                          // testa antes para que input == nullptr sinalize o erro.
+                probe.close();
+                File* f = new File(filename);     // Cria um File para o caminho fornecido.
+                input = f->read();   // pega List* // Lê o arquivo: retorna uma List* com as linhas.
+                delete f;                         // File não é usado depois.
+            }
         }
     }
 
+    // Entrada lida? false se o arquivo não existe ou não pôde ser aberto.
+    bool loaded (void)
+    {
+        return (input != nullptr);
+    }
+
     // Destrutor
     ~Assembler ()
     {
         if (input)  { delete input;  input  = nullptr; } // Libera lista de entrada.
-        if (output) { delete output; output = nullptr; } // Libera lista de saída (se houver).
+        if (emitters) {                                  // Libera as saídas registradas.
+            for (int i = 0; i < nEmitters; i++) delete emitters[i];
+            delete[] emitters; emitters = nullptr;
+        }
         if (mem)    { delete[] mem;  mem    = nullptr; } // Libera o array de 3 bytes (delete[] correto).
+        if (frames) { delete[] frames; frames = nullptr; } // Libera a pilha de expansão.
+        if (macros) { delete[] macros; macros = nullptr; } // Libera a tabela de macros.
     }
 
-    // Gravar saida no arquivo
-    void Export (const char* filename)            // Escreve a List* output no arquivo filename.
+    // Registrar saida: o Assembler passa a ser dono do Emitter (liberado no destrutor).
+    bool addEmitter (Emitter* e)                  // Deve ser chamado antes de assemble().
     {
-        if (!filename) return;                    // Se não há destino, sai.
-        File* f = new File(filename);             // Abre “File” para o destino.
-        f->write(output);                         // Grava a lista de saída (.hex).
-        // delete f; // opcional                   // Pode liberar f aqui; não é essencial em programa curto.
+        if (!e) return (false);
+        if (nEmitters >= MAX_EMITTERS) {
+            std::cerr << "ERRO: limite de " << MAX_EMITTERS << " saidas atingido.\n";
+            delete e;
+            return (false);
+        }
+        emitters[nEmitters++] = e;
+        return (true);
     }
 
     // Checar se e numero (decimal) — mantido por compatibilidade (não usado para X/Y em HEX).
@@ -132,17 +395,18 @@ public:
     }
 
     // Linhas individuais: interpreta UMA linha (X=…; Y=…; W=…;) e atualiza X,Y,W/tick.
-    void assemble (char* line)
+    // Retorna false se X=/Y= usar um nome que não é variável de um repita ativo nem só dígitos HEX.
+    bool assemble (char* line)
     {
-        if (!line) return;                  // Linha nula → ignora.
+        if (!line) return (true);           // Linha nula → ignora.
 
         // Ignora linhas de controle e vazias (ex.: "inicio:", "fim.")
-        if (std::strstr(line, "inicio") || std::strstr(line, "fim")) return;
+        if (std::strstr(line, "inicio") || std::strstr(line, "fim")) return (true);
         int n = (int)std::strlen(line);     // Tamanho da linha.
         int start = 0;
         while (start < n && std::isspace((unsigned char)line[start])) start++; // Pula espaços iniciais.
-        if (start >= n) return;             // Linha só de espaços → ignora.
-        if (line[start] == ';' || line[start] == '#') return; // Linha de comentário simples → ignora.
+        if (start >= n) return (true);      // Linha só de espaços → ignora.
+        if (line[start] == ';' || line[start] == '#') return (true); // Linha de comentário simples → ignora.
 
         bool op = false;                    // Flag: true quando for W= (operação).
         byte* cursor = nullptr;             // Aponta para X, Y ou W conforme a linha.
@@ -151,22 +415,32 @@ public:
         if (c == 'X' || c == 'x' || c == 'A' || c == 'a')      cursor = &X; // Aceita X/A como sinônimo.
         else if (c == 'Y' || c == 'y' || c == 'B' || c == 'b') cursor = &Y; // Aceita Y/B como sinônimo.
         else if (c == 'W' || c == 'w') { cursor = &W; op = true; }          // W → operação.
-        else return;                        // Qualquer outro prefixo → ignora.
+        else return (true);                 // Qualquer outro prefixo → ignora.
 
         // Procura '=' com segurança.
         int i = start + 1;
         while (i < n && line[i] != '=') i++;
-        if (i >= n) return;                 // Linha sem '=' → ignora.
+        if (i >= n) return (true);          // Linha sem '=' → ignora.
         i++;                                // Pula '='.
 
         // Pula espaços antes do valor.
         while (i < n && std::isspace((unsigned char)line[i])) i++;
-        if (i >= n) return;                 // Sem nada após '=' → ignora.
+        if (i >= n) return (true);          // Sem nada após '=' → ignora.
 
         if (!op) {
-            // Caso X= ou Y=: pegar 1 dígito HEX após '=' (2025/2).
+            // Caso X= ou Y=: variável de iteração de um repita ativo (ex.: X=i;) → 4 bits baixos do valor.
+            int e = identifier(line, i, n);
+            long v = 0;
+            if (e > i && variable(line, i, e, &v)) {
+                *cursor = (byte)(v & 0xF);
+                return (true);
+            }
+            bool hex = true;                            // "X=ff", "X=Ab": valor HEX antigo (1º dígito).
+            for (int k = i; k < e; k++) if (!isHexDigit(line[k])) hex = false;
+            if (!hex) return (false);                   // "X=cnt" fora do repita: não vira X=C em silêncio.
+            // Senão: pegar 1 dígito HEX após '=' (2025/2).
             while (i < n && !isHexDigit(line[i])) i++; // Avança até achar um dígito HEX.
-            if (i >= n) return;                         // Não achou → ignora.
+            if (i >= n) return (true);                  // Não achou → ignora.
             *cursor = (hexValue(line[i]) & 0xF);        // Converte e salva (só 4 bits).
         } else {
             // Caso W=: ler o mnemônico (somente letras contíguas).
@@ -179,71 +453,172 @@ public:
                 tick = true;                           // Marca que W foi atualizado (gera linha .hex).
             }
         }
+        return (true);
     }
 
-    // Todas as linhas: percorre input, chama assemble(line), e quando tick==true, emite uma linha no output.
-    void assemble (void)
+    // Todas as linhas: percorre input expandindo repita/macro sob demanda, chama assemble(line), e quando
+    // tick==true, repassa (X,Y,W) a todas as saídas. Uma única passada; a expansão nunca é guardada em memória.
+    // Erro no fonte descarta todas as saídas; uma saída que recusa instruções é descartada sozinha.
+    // Retorna true só se todas as saídas foram gravadas (ver Emitter::isWritten).
+    bool assemble (void)
     {
         if (!input) {
             std::cerr << "ERRO: entrada vazia ou nao lida.\n";
-            return;
+            return (false);
         }
 
-        output = new List();                // Prepara lista de saída.
-
-        // Algumas versões de List usam índice 1..N-1; aqui usamos 0..N-1 com checagem de ponteiro.
         const int total = input->getSize();
-        for (int i = 0; i < total; i++)
-        {
-            char* line_in = input->get(i); // Obtém cópia da i-ésima linha (o chamador deve liberar, dependendo da List).
-            if (!line_in) continue;        // Se nulo, pula.
-
-            assemble(line_in);             // Interpreta a linha (pode setar X,Y ou W/tick).
-
-            if (tick) {                    // Se W foi atualizado nesta linha…
-                char* line_out = new char[9]();                  // Reserva buffer p/ “XYZ\0”.
-                std::snprintf(line_out, 8, "%1X%1X%1X", X, Y, W); // Formata 3 nibbles HEX (X,Y,W).
-                output->insert(line_out);                        // Insere a linha no output (lista).
-                // não deletar line_out aqui (provável shallow-copy na List) // Atenção: se a List copiar, poderia deletar.
-                tick = false;                                     // Limpa o tick.
+        char** lines = input->toArray();     // Acesso direto às linhas (blocos voltam ao início do corpo).
+        int* ends = new int[total + 1]();    // ends[k]: linha do fim do bloco aberto na linha k.
+        bool ok = prescan(lines, total, ends);
+        bool partial = false;                // Alguma saída falhou sozinha (as demais foram gravadas).
+
+        int opened = 0;                      // Saídas abertas (temporários criados).
+        for (; ok && opened < nEmitters; opened++) // Abre todas as saídas antes de começar.
+            if (!emitters[opened]->open()) ok = false;
+
+        if (ok) {
+            depth = 0;
+            push(0, total, 1, "");           // Quadro do programa inteiro.
+
+            while (ok && depth > 0)
+            {
+                Frame* f = &frames[depth - 1];
+                if (f->pc >= f->end) {       // Fim do corpo: próxima iteração ou desempilha.
+                    if (++f->value < f->count) f->pc = f->begin;
+                    else depth--;
+                    continue;
+                }
+
+                int k = f->pc++;
+                char* line_in = lines[k];
+                if (!line_in) continue;      // Se nulo, pula.
+
+                int arg = 0;
+                Directive d = directive(line_in, &arg);
+                if (d == DIR_MACRO) {        // Definição: só é executada quando chamada.
+                    f->pc = ends[k] + 1;
+                    continue;
+                }
+                if (d == DIR_REPITA) {
+                    char var[MAX_NAME] = "";
+                    long count = 0;
+                    parseRepeat(line_in, arg, var, &count); // Já validado na pré-varredura.
+                    f->pc = ends[k] + 1;     // Ao desempilhar, continua depois do fimrepita.
+                    if (count > 0 && !push(k + 1, ends[k], count, var)) {
+                        std::cerr << "ERRO: linha " << k + 1 << ": aninhamento maior que " << MAX_DEPTH << ".\n";
+                        ok = false;
+                    }
+                    continue;
+                }
+
+                int m = findCall(line_in);
+                if (m >= 0) {
+                    if (!push(macros[m].begin, macros[m].end, 1, "")) {
+                        std::cerr << "ERRO: linha " << k + 1 << ": aninhamento maior que " << MAX_DEPTH
+                                  << " (macro " << macros[m].name << " recursiva?).\n";
+                        ok = false;
+                    }
+                    continue;
+                }
+
+                if (!assemble(line_in)) {    // Interpreta a linha (pode setar X,Y ou W/tick).
+                    std::cerr << "ERRO: linha " << k + 1 << ": valor invalido (nao e HEX nem variavel de um repita ativo): "
+                              << line_in << "\n";
+                    ok = false;
+                    continue;
+                }
+
+                if (tick) {                  // Se W foi atualizado nesta linha…
+                    for (int e = 0; e < nEmitters; e++)
+                        if (emitters[e]->isOpen() && !emitters[e]->emit(X, Y, W)) { // Repassa a instrução.
+                            emitters[e]->abort(); // Só esta saída desiste; as outras continuam.
+                            partial = true;
+                        }
+                    tick = false;                   // Limpa o tick.
+                }
             }
+            depth = 0;
 
-            // não deletar line_in aqui — a List deve gerenciar        // Evita double-free se a List gerencia internamente.
+            for (int e = 0; ok && e < nEmitters; e++)
+                if (emitters[e]->isOpen() && !emitters[e]->close()) // Finaliza e move o temporário para o destino.
+                    partial = true;
         }
+
+        if (!ok)                             // Falhou: descarta os temporários, destinos antigos ficam intactos.
+            for (int e = 0; e < opened; e++) emitters[e]->abort();
+
+        for (int k = 0; k < total; k++) std::free(lines[k]); // toArray() copia as linhas com calloc.
+        delete[] lines;
+        delete[] ends;
+        return (ok && !partial);
     }
 };
 
 #endif                                    // Fim do include guard.
 
+// Uso: assembler <entrada.ULA> [hex] [bin] [h]
+// Sem formatos, gera apenas o .hex. Todos os formatos pedidos são gerados na mesma passada.
 int main (int argc, char** argv)          // Ponto de entrada do binário “assembler”.
 {
-    if (argc != 2)                        // Espera exatamente 1 argumento: arquivo .ULA
+    if (argc < 2 || !argv || !argv[1])    // Espera o arquivo .ULA e, opcionalmente, os formatos de saída.
+    {
+        std::cerr << "ERRO: Parametros invalidos!\nForneca o arquivo de entrada como parametro.\n"
+                  << "Uso: assembler <entrada.ULA> [hex] [bin] [h]\n";
+        return 1;
+    }
+
+    char* infile = argv[1];               // Caminho do .ULA de entrada.
+    Assembler* as = new Assembler(infile); // Instancia o montador (lê o .ULA).
+    if (!as->loaded())                    // Antes de abrir qualquer saída: não toca nos arquivos antigos.
     {
-        std::cerr << "ERRO: Parametros invalidos!\nForneca o arquivo de entrada como parametro.\n";
+        std::cerr << "ERRO: nao foi possivel ler " << infile << ".\n";
+        delete as;
         return 1;
     }
 
-    if (argv && argv[1])                  // Se veio caminho de entrada…
+    Emitter* outs[MAX_EMITTERS] = {};     // Saídas registradas (o Assembler é o dono; aqui só para o feedback).
+    int nOuts = 0;
+
+    const char* formats[] = { "hex" };    // Sem formatos na linha de comando → só .hex.
+    char** fmts = (argc > 2) ? argv + 2 : (char**)formats;
+    int nFmts   = (argc > 2) ? argc - 2 : 1;
+
+    for (int a = 0; a < nFmts; a++)
     {
-        char* infile = argv[1];           // Caminho do .ULA de entrada.
-        int n = (int)std::strlen(infile);
+        const char* fmt = fmts[a];
+        for (int b = 0; b < a; b++)       // Formato repetido abriria duas saídas no mesmo arquivo.
+            if (std::strcmp(fmt, fmts[b]) == 0) {
+                std::cerr << "ERRO: formato repetido: " << fmt << ".\n";
+                delete as;
+                return 1;
+            }
 
-        // Cria nome de saída com .hex (copia tudo até o primeiro '.' e concatena ".hex").
-        char* outfile = (char*)std::calloc((size_t)n + 5, sizeof(char)); // +5 cabe ".hex" e '\0'.
-        int i = 0;
-        while (i < n && infile[i] != '.') {
-            outfile[i] = infile[i];
-            i++;
+        char* outfile = nullptr;
+        Emitter* e = nullptr;
+
+        // Nome de saída: troca a extensão do arquivo (não corta no primeiro '.' do caminho).
+        if      (std::strcmp(fmt, "hex") == 0) { outfile = outputPath(infile, ".hex"); e = new HexEmitter(outfile); }
+        else if (std::strcmp(fmt, "bin") == 0) { outfile = outputPath(infile, ".bin"); e = new BinEmitter(outfile); }
+        else if (std::strcmp(fmt, "h")   == 0) { outfile = outputPath(infile, ".h");   e = new HeaderEmitter(outfile); }
+        else {
+            std::cerr << "ERRO: formato desconhecido: " << fmt << " (use hex, bin ou h).\n";
+            delete as;
+            return 1;
         }
-        std::strcat(outfile, ".hex");     // Acrescenta extensão .hex
-
-        Assembler* as = new Assembler(infile); // Instancia o montador (lê o .ULA).
-        as->assemble();                         // Converte input → output (List com linhas .hex).
-        as->Export(outfile);                    // Grava o .hex no disco.
-		std::cout << "Gerado: " << outfile << std::endl;  // Mensagem de feedback do caminho gerado.
+        if (outfile) std::free(outfile);  // O Emitter guarda sua própria cópia do caminho.
 
-        if (outfile) std::free(outfile);        // Libera o buffer alocado com calloc.
-        delete as;                              // Libera o Assembler (e suas List internas).
+        if (!as->addEmitter(e)) { delete as; return 1; }
+        outs[nOuts++] = e;
     }
-    return 0;                                   // Fim normal do programa.
+
+    int res = as->assemble() ? 0 : 1;     // Uma passada: converte input e grava todas as saídas.
+    for (int i = 0; i < nOuts; i++)
+        if (outs[i]->isWritten())
+            std::cout << "Gerado: " << outs[i]->getFilename() << std::endl; // Feedback dos caminhos gerados.
+        else if (res == 1 && outs[i]->getFilename())
+            std::cerr << "ERRO: " << outs[i]->getFilename() << " nao foi gerado.\n";
+
+    delete as;                            // Libera o Assembler (e suas saídas).
+    return res;                           // 0 = sucesso.
 }
@@ -0,0 +1,268 @@
+#ifndef EMITTER_H               // Include guard: evita múltiplas inclusões do mesmo header.
+#define EMITTER_H
+
+#include <iostream>             // std::cerr (mensagens de erro ao abrir arquivos).
+#include <fstream>              // std::fstream para gravar as saídas.
+#include <cstdint>              // tipos fixos (uint8_t).
+#include <cstdio>               // snprintf, rename, remove.
+#include <cstring>              // strlen, strcpy, strcat.
+#include <cctype>               // isalnum, toupper.
+#include <cstdlib>              // calloc, free.
+
+#define HEADER_MAX_WORDS 16383  // Maior array de uint16_t em um objeto AVR (32767 bytes), endereçável por pgm_read_word.
+
+// Criar caminho de saida: troca a extensão do arquivo de entrada por ext.
+// Só considera o '.' depois da última barra ('/' ou '\\'), então "./dir/prog.ULA" → "./dir/prog.hex"
+// e "dir.v2/prog" → "dir.v2/prog.hex". O chamador deve liberar o retorno com free().
+static inline char* outputPath (const char* infile, const char* ext)
+{
+    if (!infile || !ext) return (nullptr);
+
+    int n = (int)std::strlen(infile);
+    int base = 0;                               // Início do nome do arquivo (depois da última barra).
+    for (int i = 0; i < n; i++)
+        if (infile[i] == '/' || infile[i] == '\\') base = i + 1;
+
+    int end = n;                                // Fim do nome sem extensão.
+    for (int i = n - 1; i > base; i--)          // i > base: ".oculto" não é tratado como extensão.
+        if (infile[i] == '.') { end = i; break; }
+
+    char* res = (char*)std::calloc((size_t)end + std::strlen(ext) + 1, sizeof(char));
+    if (res) {
+        for (int i = 0; i < end; i++) res[i] = infile[i];
+        std::strcat(res, ext);
+    }
+    return (res);
+}
+
+// Saida generica: recebe cada instrução (X, Y, W) no momento em que é montada.
+// O Assembler faz uma única passada pela entrada e repassa a instrução para todas as saídas registradas.
+// A gravação vai para "<destino>.tmp"; só close() com sucesso troca o destino, então uma montagem
+// que falha (abort()) não apaga o último arquivo bom.
+class Emitter
+{
+    protected:
+
+    // Atributos
+    char* filename;             // Caminho de destino (cópia própria, liberada no destrutor).
+    char* tmpname;              // Caminho temporário onde a saída é escrita ("<destino>.tmp").
+    std::fstream fs;            // Arquivo de saída.
+    int count;                  // Quantidade de instruções recebidas.
+    bool written;               // true depois de um close() bem-sucedido.
+
+    // Modo de abertura do arquivo (texto por padrão).
+    virtual std::ios::openmode mode (void) { return (std::ios::out); }
+
+    public:
+
+    // Construtor
+    Emitter (const char* filename)
+    : filename(nullptr), tmpname(nullptr), count(0), written(false)
+    {
+        if (filename) {
+            this->filename = new char[std::strlen(filename) + 1]();
+            std::strcpy(this->filename, filename);
+            tmpname = new char[std::strlen(filename) + 5]();
+            std::strcpy(tmpname, filename);
+            std::strcat(tmpname, ".tmp");
+        }
+    }
+
+    // Destrutor
+    virtual ~Emitter ()
+    {
+        if (fs.is_open()) abort();  // Nunca finalizada: descarta o temporário.
+        if (filename) { delete[] filename; filename = nullptr; }
+        if (tmpname)  { delete[] tmpname;  tmpname  = nullptr; }
+    }
+
+    const char* getFilename (void) { return (filename); }
+    bool isOpen (void)             { return (fs.is_open()); }  // Ainda recebendo instruções.
+    bool isWritten (void)          { return (written); }       // Destino substituído com sucesso.
+
+    // Abrir arquivo temporário; retorna false se falhar.
+    virtual bool open (void)
+    {
+        if (!tmpname) return (false);
+        fs.open(tmpname, mode());
+        if (!fs) {
+            std::cerr << "ERRO: nao foi possivel abrir " << tmpname << " para escrita.\n";
+            return (false);
+        }
+        return (true);
+    }
+
+    // Gravar uma instrução (3 nibbles: X, Y, W); retorna false se a saída não aceitar mais instruções.
+    virtual bool emit (uint8_t x, uint8_t y, uint8_t w) = 0;
+
+    // Finalizar arquivo (rodapé, padding), fechar e mover o temporário para o destino.
+    virtual bool close (void)
+    {
+        if (!fs.is_open()) return (false);
+        fs.close();
+        bool ok = !fs.fail();
+        if (ok && std::rename(tmpname, filename) != 0) { // No Windows rename() não sobrescreve o destino.
+            std::remove(filename);
+            ok = (std::rename(tmpname, filename) == 0);
+        }
+        if (!ok) {
+            std::cerr << "ERRO: nao foi possivel gravar " << filename << ".\n";
+            std::remove(tmpname);
+            return (false);
+        }
+        written = true;
+        return (true);
+    }
+
+    // Desistir da saída: fecha e apaga o temporário, mantendo o destino como estava.
+    void abort (void)
+    {
+        if (fs.is_open()) fs.close();
+        if (tmpname) std::remove(tmpname);
+    }
+};
+
+// Saida .hex: uma instrução "XYW" por linha, no mesmo formato do antigo File::write
+// (linhas separadas por '\n' e um espaço depois da última, sem '\n' final).
+class HexEmitter : public Emitter
+{
+    public:
+
+    HexEmitter (const char* filename) : Emitter(filename) {}
+
+    bool emit (uint8_t x, uint8_t y, uint8_t w)
+    {
+        char line[4] = "";
+        std::snprintf(line, sizeof(line), "%1X%1X%1X", x & 0xF, y & 0xF, w & 0xF);
+        if (count > 0) fs << "\n";              // Separador antes de cada linha, exceto a primeira.
+        fs << line;
+        count++;
+        return (true);
+    }
+
+    bool close (void)
+    {
+        if (fs.is_open() && count > 0) fs << " "; // Espaço no fim (compatível com o .hex antigo).
+        return (Emitter::close());
+    }
+};
+
+// Saida binaria: nibbles X, Y, W empacotados em sequência (2 instruções = 3 bytes).
+// Nibble alto primeiro; se o total de nibbles for ímpar, o último byte é completado com 0.
+class BinEmitter : public Emitter
+{
+    private:
+
+    uint8_t pending;            // Byte parcialmente preenchido (nibble alto já gravado).
+    bool half;                  // true quando 'pending' espera o nibble baixo.
+
+    void put (uint8_t nibble)
+    {
+        if (!half) {
+            pending = (uint8_t)((nibble & 0xF) << 4);
+            half = true;
+        } else {
+            fs.put((char)(pending | (nibble & 0xF)));
+            half = false;
+        }
+    }
+
+    protected:
+
+    std::ios::openmode mode (void) { return (std::ios::out | std::ios::binary); }
+
+    public:
+
+    BinEmitter (const char* filename) : Emitter(filename), pending(0), half(false) {}
+
+    bool emit (uint8_t x, uint8_t y, uint8_t w)
+    {
+        put(x);
+        put(y);
+        put(w);
+        count++;
+        return (true);
+    }
+
+    bool close (void)
+    {
+        if (fs.is_open() && half) put(0x0);    // Completa o último byte com nibble 0.
+        return (Emitter::close());
+    }
+};
+
+// Saida C: header com um array PROGMEM (uma palavra 0x0XYW por instrução) para compilar o programa no sketch.
+// Ler no Arduino com pgm_read_word(&NOME[i]); X = (v >> 8) & 0xF, Y = (v >> 4) & 0xF, W = v & 0xF.
+// Limitado a HEADER_MAX_WORDS instruções: acima disso o array não cabe em um objeto AVR.
+class HeaderEmitter : public Emitter
+{
+    private:
+
+    char* name;                 // Identificador C derivado do nome do arquivo (ex.: "TESTEULA").
+
+    public:
+
+    HeaderEmitter (const char* filename)
+    : Emitter(filename), name(nullptr)
+    {
+        if (!this->filename) return;
+
+        // Nome do array: parte do caminho após a última barra, até o último '.', só [A-Za-z0-9_].
+        const char* s = this->filename;
+        for (const char* p = this->filename; *p; p++)
+            if (*p == '/' || *p == '\\') s = p + 1;
+        int n = (int)std::strlen(s);
+        for (int i = n - 1; i > 0; i--)
+            if (s[i] == '.') { n = i; break; }
+
+        name = new char[n + 2]();
+        int j = 0;
+        if (n == 0 || std::isdigit((unsigned char)s[0])) name[j++] = '_'; // Identificador não pode começar com dígito.
+        for (int i = 0; i < n; i++)
+            name[j++] = std::isalnum((unsigned char)s[i]) ? (char)std::toupper((unsigned char)s[i]) : '_';
+    }
+
+    ~HeaderEmitter ()
+    {
+        if (name) { delete[] name; name = nullptr; }
+    }
+
+    bool open (void)
+    {
+        if (!Emitter::open()) return (false);
+        fs << "#ifndef " << name << "_H\n";
+        fs << "#define " << name << "_H\n\n";
+        fs << "#include <avr/pgmspace.h>\n\n";
+        fs << "// Gerado pelo assembler: uma palavra 0x0XYW por instrucao.\n";
+        fs << "const uint16_t " << name << "[] PROGMEM = {";
+        return (true);
+    }
+
+    bool emit (uint8_t x, uint8_t y, uint8_t w)
+    {
+        if (count >= HEADER_MAX_WORDS) {
+            std::cerr << "ERRO: " << filename << ": mais de " << HEADER_MAX_WORDS
+                      << " instrucoes nao cabem em um array PROGMEM.\n";
+            return (false);
+        }
+        char word[8] = "";
+        std::snprintf(word, sizeof(word), "0x0%1X%1X%1X", x & 0xF, y & 0xF, w & 0xF);
+        if (count > 0) fs << ",";
+        fs << ((count % 8 == 0) ? "\n    " : " ") << word; // 8 palavras por linha.
+        count++;
+        return (true);
+    }
+
+    bool close (void)
+    {
+        if (fs.is_open()) {
+            if (count == 0) fs << " 0x0000"; // Array vazio não é válido em C; tamanho continua 0.
+            fs << "\n};\n";
+            fs << "const uint32_t " << name << "_SIZE = " << count << ";\n\n";
+            fs << "#endif\n";
+        }
+        return (Emitter::close());
+    }
+};
+
+#endif                          // Fim do include guard.
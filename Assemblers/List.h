@@ -153,6 +153,22 @@ class List
         }
         return (res);           // Retorna cópia (o chamador deve liberar).
     }
+
+    // Copiar todas as linhas para um vetor [0..n-1] em uma única caminhada (get(p) custa O(p) por chamada).
+    char** toArray (void)       // O chamador libera cada linha com free() e o vetor com delete[].
+    {
+        char** res = new char*[n + 1](); // +1: vetor nunca tem tamanho zero e termina em NULL.
+        int i = 0;
+        for (Cell* ptr = head; ptr && i < n; ptr = ptr->link, i++)
+        {
+            res[i] = (char*)calloc(strlen(ptr->str)+1, sizeof(char)); // Mesma convenção de get(): cópia via calloc.
+            if (res[i])
+            {
+                strcpy(res[i], ptr->str);
+            }
+        }
+        return (res);
+    }
 };
 
 #endif                          // Fim do include guard.